@@ -0,0 +1,36 @@
+#include "csr.h"
+#include "graph.h"
+#include <algorithm>
+
+int assemble_upper_csr(const graph &g, int **row_idx_out, int **columns_out, double **values_out) {
+    int n = g.nodes.size();
+    std::vector<std::vector<int> > adj = g.symmetrised();
+    int *row_idx = new int[n+1];
+    row_idx[0] = 1;
+    
+    for (int i = 0; i < n; ++i) {
+        //diagonal plus the upper triangle part, adj is sorted
+        int upper = adj[i].end() - std::upper_bound(adj[i].begin(), adj[i].end(), i);
+        row_idx[i+1] = row_idx[i] + upper + 1;
+    }
+    
+    int nnz = row_idx[n] - 1;
+    double *values = new double[nnz];
+    int *columns = new int[nnz];
+    
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        int c = row_idx[i] - 1;
+        columns[c] = i+1;
+        values[c++] = adj[i].size() + 1.0;
+        for (auto j = std::upper_bound(adj[i].begin(), adj[i].end(), i); j != adj[i].end(); ++j) {
+            columns[c] = *j+1;
+            values[c++] = -1.0;
+        }
+    }
+    
+    *row_idx_out = row_idx;
+    *columns_out = columns;
+    *values_out = values;
+    return n;
+}
@@ -0,0 +1,20 @@
+#ifndef CSR_H
+#define CSR_H
+
+class graph;
+
+/**
+ * @brief assemble the upper triangle of the graph matrix in 1-based csr format
+ *
+ * This is the layout pardiso expects. The matrix is the shifted laplacian of
+ * the symmetrised graph, degree+1 on the diagonal and -1 for every edge, so
+ * it is symmetric positive definite. The arrays are allocated with new[].
+ * @param g input graph
+ * @param row_idx n+1 row offsets
+ * @param columns column indices
+ * @param values matrix values
+ * @return number of rows
+ */
+int assemble_upper_csr(const graph &g, int **row_idx, int **columns, double **values);
+
+#endif // CSR_H
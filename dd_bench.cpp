@@ -0,0 +1,75 @@
+#include "graph.h"
+#include "partition.h"
+#include "schwarz.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+
+#define DD_BENCH_FILE_MASK "dd_bench_%dn_%dk_%dcores.txt"
+
+int main(int argc, char **argv) {
+   if (argc == 3 && strcmp(argv[1], "--dd-worker") == 0) {
+      return schwarz::worker(atoi(argv[2]));
+   }
+
+   if (argc < 4) {
+      std::cout << "usage: " << argv[0] << " n k max_subdomains" << std::endl;
+      return -1;
+   }
+
+   int n = atoi(argv[1]);
+   int k = atoi(argv[2]);
+   int max_parts = atoi(argv[3]);
+
+   char *var = getenv("OMP_NUM_THREADS");
+   if (var == NULL) {
+      std::cout << "set OMP_NUM_THREADS" << std::endl;
+      exit(-1);
+   }
+   int threads = atoi(var);
+
+   char bench_file_path[1024];
+   snprintf(bench_file_path, 1024, DD_BENCH_FILE_MASK, n, k, threads);
+   if (access(bench_file_path, F_OK) == 0) {
+      std::cout << "benchfile exists" << std::endl;
+      exit(-1);
+   }
+
+   graph g = graph::random(n, k);
+   if (!g.is_connected())
+      g.make_connected();
+
+   //the core count stays fixed unless there are more subdomains than threads,
+   //efficiency compares core seconds against the single subdomain run
+   double t1 = 0.0, core_seconds1 = 0.0;
+   for (int parts = 1; parts <= max_parts; parts *= 2) {
+      std::vector<int> part = partition_rcb(g, parts);
+      int cut = edge_cut(g, part);
+
+      schwarz dd(g, part);
+      int worker_threads = std::max(1, threads / parts);
+      double setup = dd.setup(worker_threads);
+      double solve = dd.solve();
+      double t = setup + solve;
+      double core_seconds = t * parts * worker_threads;
+      if (parts == 1) {
+         t1 = t;
+         core_seconds1 = core_seconds;
+      }
+
+      //n,k,subdomains,edge cut,iterations,setup,solve
+      FILE *bench_file = fopen(bench_file_path, "a");
+      fprintf(bench_file, "%d,%d,%d,%d,%d,%f,%f\n", n, k, parts, cut,
+              dd.iterations(), setup, solve);
+      fclose(bench_file);
+
+      std::cout << parts << " subdomains: cut " << cut << " iterations " << dd.iterations()
+                << " setup " << setup << "s solve " << solve << "s speedup "
+                << t1 / t << " efficiency " << core_seconds1 / core_seconds
+                << std::endl;
+   }
+   return 0;
+}
@@ -1,4 +1,5 @@
 #include "graph.h"
+#include "stats.h"
 #include <iostream>
 
 int main(int argc, char **argv) {
@@ -14,14 +15,11 @@ int main(int argc, char **argv) {
          g.make_connected();
       snprintf(path, 1024, "matrix_%d-%d.dat", n, k);
       g.dump_matlab(path);
-      snprintf(path, 1024, "matrix_%d-%d.dat", n, k);
-      
-      double avg_k = 0.0;
+      snprintf(path, 1024, "matrix_%d-%d.png", n, k);
+      g.plot_raster(path);
       
-      for (int i = 0; i < g.connections.size(); i++) {
-         avg_k += g.connections[i].size() - 1;
-      }
-      std::cout << "average k: " << (avg_k/g.connections.size()) << " " << k << std::endl;
+      std::cout << "k: " << k << std::endl;
+      graph_stats::analyse(g).print(std::cout);
    }
    return 0;
 }
@@ -0,0 +1,36 @@
+#include "tiled_graph.h"
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+#include <cstdint>
+
+int main(int argc, char **argv) {
+   if (argc < 4) {
+      std::cout << "usage: " << argv[0] << " n k file [seed]" << std::endl;
+      return -1;
+   }
+
+   int64_t n = atoll(argv[1]);
+   int k = atoi(argv[2]);
+   const char *file = argv[3];
+   uint64_t seed = argc > 4 ? strtoull(argv[4], 0, 10) : std::time(0);
+
+   if (n <= k || k < 1) {
+      std::cout << "need n > k > 0" << std::endl;
+      return -1;
+   }
+   if (n > INT32_MAX) {
+      std::cout << "node ids are stored as int32, n must not exceed " << INT32_MAX << std::endl;
+      return -1;
+   }
+
+   std::cout << "generating " << n << " nodes with k=" << k
+             << " seed=" << seed << " into " << file << std::endl;
+
+   tiled_graph tg(n, k, seed);
+   if (!tg.generate(file)) {
+      std::cerr << "could not write " << file << std::endl;
+      return -1;
+   }
+   return 0;
+}
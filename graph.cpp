@@ -1,6 +1,8 @@
 #include "graph.h"
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <algorithm>
 
 #include <boost/random.hpp>
 
@@ -8,6 +10,10 @@ boost::random::mt19937 rng(std::time(0));
 //boost::random::normal_distribution<> gen(0.0, 0.7);
 boost::random::uniform_01<> gen;
 
+void graph::seed(unsigned s) {
+    rng.seed(s);
+}
+
 void graph::dump_matlab(const char *file) const {
     FILE *out = fopen(file, "w");
     for (int i = 0; i < nodes.size(); ++i) {
@@ -20,10 +26,23 @@ void graph::dump_matlab(const char *file) const {
 
 #include <QPrinter>
 #include <QPainter>
+#include <QImage>
 #include <QApplication>
 
 #define SCALE 700
 #define MARGIN 15
+#define DENSITY_PIXELS 16 //below this many pixels per node plot_raster draws density
+#define NODE_RADIUS 2
+
+/**
+ * @brief edge i->j is drawn only once if j->i exists too
+ */
+static bool first_of_pair(const graph &g, int i, int j) {
+    if (i < j)
+        return true;
+    const std::vector<int> &back = g.connections[j];
+    return std::find(back.begin(), back.end(), i) == back.end();
+}
     
 /**
  * @brief plot graph g to a pdf
@@ -58,6 +77,8 @@ void graph::plot(const char *file) const {
         p.setPen(arc_pen);
         p.drawArc(from.x*SCALE-2,from.y*SCALE-2, 4, 4, 0, 16*360);
         for (int j = 0; j < connections[i].size(); ++j) {
+            if (!first_of_pair(*this, i, connections[i][j]))
+                continue;
             coord to = nodes[connections[i][j]];
             p.setPen(line_pen);
             p.drawLine(from.x*SCALE, from.y*SCALE, to.x*SCALE, to.y*SCALE);
@@ -66,6 +87,99 @@ void graph::plot(const char *file) const {
     p.end();
 }
 
+void graph::plot_raster(const char *file, int size, int tiles) const {
+    const int tile_px = (size + tiles - 1) / tiles;
+    const int nt = tiles*tiles;
+    const bool density = nodes.size()*DENSITY_PIXELS > size_t(size)*size;
+
+    QImage image(size, size, QImage::Format_RGB32);
+    uchar *bits = image.bits(); //detach here, tiles write disjoint regions
+    const int bpl = image.bytesPerLine();
+
+    auto tile_range = [&](double lo, double hi, int *first, int *last) {
+        *first = std::max(0, int((lo*size - NODE_RADIUS) / tile_px));
+        *last = std::min(tiles-1, int((hi*size + NODE_RADIUS) / tile_px));
+    };
+
+    if (density) {
+        std::vector<unsigned> counts(size_t(size)*size, 0);
+        for (const coord &c: nodes) {
+            int px = std::min(size-1, std::max(0, int(c.x*size)));
+            int py = std::min(size-1, std::max(0, int(c.y*size)));
+            counts[size_t(py)*size + px]++;
+        }
+        unsigned max_count = *std::max_element(counts.begin(), counts.end());
+        double norm = 255.0 / std::log(1.0 + max_count);
+
+#pragma omp parallel for
+        for (int y = 0; y < size; ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(bits + size_t(y)*bpl);
+            for (int x = 0; x < size; ++x) {
+                int v = 255 - int(std::log(1.0 + counts[size_t(y)*size + x]) * norm);
+                line[x] = qRgb(v, v, v);
+            }
+        }
+        image.save(file);
+        return;
+    }
+
+    std::vector<std::vector<int> > tile_nodes(nt);
+    std::vector<std::vector<std::pair<int, int> > > tile_edges(nt);
+    for (int i = 0; i < nodes.size(); ++i) {
+        const coord &from = nodes[i];
+        int x0, x1, y0, y1;
+        tile_range(from.x, from.x, &x0, &x1);
+        tile_range(from.y, from.y, &y0, &y1);
+        for (int ty = y0; ty <= y1; ++ty)
+            for (int tx = x0; tx <= x1; ++tx)
+                tile_nodes[ty*tiles + tx].push_back(i);
+
+        for (int j: connections[i]) {
+            if (j == i || !first_of_pair(*this, i, j))
+                continue;
+            const coord &to = nodes[j];
+            tile_range(std::min(from.x, to.x), std::max(from.x, to.x), &x0, &x1);
+            tile_range(std::min(from.y, to.y), std::max(from.y, to.y), &y0, &y1);
+            for (int ty = y0; ty <= y1; ++ty)
+                for (int tx = x0; tx <= x1; ++tx)
+                    tile_edges[ty*tiles + tx].push_back(std::make_pair(i, j));
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < nt; ++t) {
+        const int tx = t % tiles, ty = t / tiles;
+        const int w = std::min(tile_px, size - tx*tile_px);
+        const int h = std::min(tile_px, size - ty*tile_px);
+        if (w <= 0 || h <= 0)
+            continue;
+
+        QImage tile(w, h, QImage::Format_RGB32);
+        tile.fill(qRgb(255, 255, 255));
+        QPainter p(&tile);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.translate(-tx*tile_px, -ty*tile_px);
+
+        p.setPen(QPen(QColor(0, 0, 0, 128), 0));
+        for (const std::pair<int, int> &e: tile_edges[t]) {
+            const coord &from = nodes[e.first], &to = nodes[e.second];
+            p.drawLine(QPointF(from.x*size, from.y*size), QPointF(to.x*size, to.y*size));
+        }
+        p.setPen(QPen(Qt::black, 1));
+        for (int i: tile_nodes[t]) {
+            p.drawEllipse(QPointF(nodes[i].x*size, nodes[i].y*size), NODE_RADIUS, NODE_RADIUS);
+        }
+        p.end();
+
+        for (int y = 0; y < h; ++y) {
+            memcpy(bits + size_t(ty*tile_px + y)*bpl + size_t(tx*tile_px)*sizeof(QRgb),
+                   tile.constScanLine(y), w*sizeof(QRgb));
+        }
+    }
+
+    image.save(file);
+}
+
 void knn(std::vector<graph::coord> nodes, const graph::coord &theone, 
          int k) {
     
@@ -206,11 +320,30 @@ bool graph::is_connected(bool *seen) const {
    return reachable == nodes.size();
 }
 
+std::vector<std::vector<int> > graph::symmetrised() const {
+    int n = nodes.size();
+    std::vector<std::vector<int> > adj(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j: connections[i]) {
+            if (j == i)
+                continue;
+            adj[i].push_back(j);
+            adj[j].push_back(i);
+        }
+    }
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        std::sort(adj[i].begin(), adj[i].end());
+        adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+    }
+    return adj;
+}
+
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
 #include <boost/graph/strong_components.hpp>
 
-void graph::make_connected() {
+int graph::make_connected() {
     boost::adjacency_list<boost::vecS, boost::vecS, boost::bidirectionalS> g;
     for (int i = 0; i < connections.size(); i++) {
         for (int j = 0; j < connections[i].size(); j++) {
@@ -238,4 +371,5 @@ void graph::make_connected() {
         assert(new_vertex.first >= 0);
     }
     assert(is_connected());
+    return nc-1;
 }
@@ -30,6 +30,12 @@ public:
      * @return the random graph
      */
     static graph random(int n, int k);
+    
+    /**
+     * @brief seed the generator used by random for reproducible graphs
+     * @param s the seed
+     */
+    static void seed(unsigned s);
 
     /**
      * @brief dump graph for loading int matlab with load and spconvert
@@ -49,6 +55,17 @@ public:
      */
     void plot(const char *file) const;
     
+    /**
+     * @brief render to an image file (png, ...), tiles are rendered in parallel
+     *
+     * Symmetric edges are drawn once. If there are less than a few pixels per
+     * node only the node density is drawn.
+     * @param file
+     * @param size width and height in pixels
+     * @param tiles number of tiles per side
+     */
+    void plot_raster(const char *file, int size = 2048, int tiles = 8) const;
+    
     /**
      * @brief make_symmetric
      * @return 
@@ -62,7 +79,17 @@ public:
     bool is_connected() const;
     bool is_connected(bool *seen) const;
     
-    void make_connected();
+    /**
+     * @brief bridges consecutive strong components with one edge each
+     * @return number of edges added
+     */
+    int make_connected();
+    
+    /**
+     * @brief adjacency of the symmetrised graph (i-j if either node lists the other)
+     * @return sorted neighbor lists without self loops
+     */
+    std::vector<std::vector<int> > symmetrised() const;
     
     
     std::vector<coord> nodes;
@@ -1,5 +1,7 @@
 #include "graph.h"
 #include "solver.h"
+#include "stats.h"
+#include "results_sink.h"
 #include <cassert>
 
 #include <QApplication>
@@ -13,12 +15,20 @@
 #define EN_BINARY_PATH "./parpenet/src/epanet2"
 
 
-void run(int n, int k, QString bench_file_path) {
+/**
+ * @brief benchmark one graph and queue its row
+ * @return false if epanet could not be started
+ */
+bool run(int n, int k, results_sink &sink) {
    
    //create random graph and dunmp to a tmp epanet file
    graph g = graph::random(n, k);
+   int bridges = 0;
    if (!g.is_connected())
-       g.make_connected();
+       bridges = g.make_connected();
+   
+   graph_stats stats = graph_stats::analyse(g);
+   stats.bridges = bridges;
 
    //g.make_symmetric();
    
@@ -26,13 +36,13 @@ void run(int n, int k, QString bench_file_path) {
    tmpnam(tmp);
    g.dump_epanet(tmp);
    
-   FILE *bench_file = fopen(bench_file_path.toLocal8Bit().constData(), "a");
-   fprintf(bench_file, "%d,%d,", n, k);
-   fclose(bench_file);
+   //epanet appends its timings to a file of its own, the complete row is queued afterwards
+   char timing_file[L_tmpnam];
+   tmpnam(timing_file);
    
    //prepare for epanet run
    QProcessEnvironment penv = QProcessEnvironment::systemEnvironment();
-   penv.insert("EN_BENCH_FILE", bench_file_path);
+   penv.insert("EN_BENCH_FILE", timing_file);
    QProcess p;
    p.setProcessEnvironment(penv);
    
@@ -43,16 +53,40 @@ void run(int n, int k, QString bench_file_path) {
    p.start(EN_BINARY_PATH, args);
    if (!p.waitForStarted()) {
       std::cerr << "could not start epanet process" << std::endl;
-      exit(-1);
+      QFile::remove(tmp);
+      return false;
    }
    std::cout << "started process with pid " << p.pid() << std::endl;
    p.waitForFinished(-1);
    //std::cout << p.readAllStandardError().constData() << std::endl;
    //std::cout << p.readAllStandardOutput().constData() << std::endl;
    
+   double seq, par;
+   FILE *timings = fopen(timing_file, "r");
+   if (!timings || fscanf(timings, "%lf,%lf", &seq, &par) != 2) {
+      std::cerr << "no timings from epanet for n=" << n << " k=" << k << std::endl;
+   } else {
+      results_sink::record r;
+      r.fields[0] = n;
+      r.fields[1] = k;
+      r.count = 2 + stats.fields(r.fields + 2);
+      r.fields[r.count++] = seq;
+      r.fields[r.count++] = par;
+      int len = snprintf(r.text, RESULTS_MAX_TEXT, "%s", stats.histogram().c_str());
+      if (len < 0 || len >= RESULTS_MAX_TEXT) {
+         std::cerr << "degree histogram does not fit into the row, dropped n=" << n << " k=" << k << std::endl;
+      } else {
+         sink.push(r);
+      }
+   }
+   if (timings)
+      fclose(timings);
+   
    //cleanup
    QFile::remove(EN_OUT_FILE);
    QFile::remove(tmp);
+   QFile::remove(timing_file);
+   return true;
 }
 
 int main(int argc, char **argv) {
@@ -84,11 +118,41 @@ int main(int argc, char **argv) {
        exit(-1);
     }
     
+    //--binary keeps a binary copy of the numeric columns next to the csv,
+    //column names in <benchfile>.bin.hdr
+    QString binary_path = bench_file_path + ".bin";
+    bool binary = app.arguments().contains("--binary");
+    results_sink sink(bench_file_path.toLocal8Bit().constData(),
+                      std::string("n,k,") + graph_stats::csv_header() + ",seq,par",
+                      "degree_histogram",
+                      binary ? binary_path.toLocal8Bit().constData() : 0);
+    if (!sink.ok()) {
+       std::cout << "could not open benchfile" << std::endl;
+       exit(-1);
+    }
+    
+    //no exit() while the sink lives, its destructor writes the queued rows
+    bool binary_warned = false;
     for (int n = n_start; n <= n_stop; n+= 200) {
        for (int k = k_start; k <= k_stop; k+= 1) {
-          run(n, k, bench_file_path);
+          if (!run(n, k, sink))
+             return -1;
+          if (!sink.ok()) {
+             std::cout << "writing benchfile failed" << std::endl;
+             return -1;
+          }
+          if (binary && !binary_warned && !sink.binary_ok()) {
+             std::cout << "writing " << binary_path.toLocal8Bit().constData()
+                       << " failed, continuing with the csv only" << std::endl;
+             binary_warned = true;
+          }
        }
     }
     
+    sink.flush();
+    if (!sink.ok()) {
+       std::cout << "writing benchfile failed" << std::endl;
+       return -1;
+    }
     return 0;
 }
@@ -0,0 +1,59 @@
+#include "partition.h"
+#include "graph.h"
+#include <algorithm>
+
+static void bisect(const graph &g, std::vector<int>::iterator begin,
+                   std::vector<int>::iterator end, int first_part, int parts,
+                   std::vector<int> &part) {
+    if (parts == 1) {
+        for (auto it = begin; it != end; ++it) {
+            part[*it] = first_part;
+        }
+        return;
+    }
+
+    double min_x = 1e300, max_x = -1e300, min_y = 1e300, max_y = -1e300;
+    for (auto it = begin; it != end; ++it) {
+        const graph::coord &c = g.nodes[*it];
+        min_x = std::min(min_x, c.x); max_x = std::max(max_x, c.x);
+        min_y = std::min(min_y, c.y); max_y = std::max(max_y, c.y);
+    }
+    bool split_x = max_x - min_x >= max_y - min_y;
+
+    int left_parts = parts / 2;
+    auto mid = begin + (end - begin) * left_parts / parts;
+    std::nth_element(begin, mid, end, [&g, split_x](int a, int b) {
+        return split_x ? g.nodes[a].x < g.nodes[b].x : g.nodes[a].y < g.nodes[b].y;
+    });
+
+#pragma omp task shared(g, part) if (end - begin > 10000)
+    bisect(g, begin, mid, first_part, left_parts, part);
+    bisect(g, mid, end, first_part + left_parts, parts - left_parts, part);
+#pragma omp taskwait
+}
+
+std::vector<int> partition_rcb(const graph &g, int parts) {
+    std::vector<int> part(g.nodes.size(), 0);
+    std::vector<int> items(g.nodes.size());
+    int first = 0;
+    std::generate(items.begin(), items.end(), [&first]{ return first++; });
+
+#pragma omp parallel
+#pragma omp single
+    bisect(g, items.begin(), items.end(), 0, parts, part);
+
+    return part;
+}
+
+int edge_cut(const graph &g, const std::vector<int> &part) {
+    std::vector<std::vector<int> > adj = g.symmetrised();
+    int cut = 0;
+#pragma omp parallel for reduction(+:cut)
+    for (int i = 0; i < adj.size(); ++i) {
+        for (int j: adj[i]) {
+            if (i < j && part[i] != part[j])
+                cut++;
+        }
+    }
+    return cut;
+}
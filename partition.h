@@ -0,0 +1,27 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <vector>
+
+class graph;
+
+/**
+ * @brief recursive coordinate bisection of the graph nodes
+ *
+ * Every step splits along the longer side of the bounding box, the split
+ * position is chosen so the part sizes stay proportional when parts is not
+ * a power of two.
+ * @param g the graph
+ * @param parts number of parts
+ * @return part of every node
+ */
+std::vector<int> partition_rcb(const graph &g, int parts);
+
+/**
+ * @brief number of edges of the symmetrised graph connecting nodes of different parts
+ * @param g the graph
+ * @param part part of every node
+ */
+int edge_cut(const graph &g, const std::vector<int> &part);
+
+#endif // PARTITION_H
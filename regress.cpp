@@ -0,0 +1,220 @@
+#include "graph.h"
+#include "csr.h"
+#include "stats.h"
+#ifdef WITH_PARDISO
+#include "solver.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define REGRESS_SEED 4711
+#define REGRESS_REPEATS 5
+#define REGRESS_TOLERANCE 0.10  //relative slowdown that is always accepted
+#define REGRESS_MIN_DIFF 0.0005 //seconds, differences below are timer noise
+#define REGRESS_MAD_FACTOR 3.0  //accepted slowdown in robust standard deviations
+
+struct suite_entry {
+   int n, k;
+};
+
+static const suite_entry suite[] = {
+   {1000, 4}, {1000, 12}, {5000, 4}, {5000, 12}, {20000, 4}, {20000, 12}
+};
+
+struct measurement {
+   std::string phase;
+   int n, k;
+   double median, mad;
+   long nnz; //of the generated matrix, tells if the graph itself changed
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double seconds_since(bench_clock::time_point start) {
+   return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+static measurement summarise(const char *phase, int n, int k, long nnz, std::vector<double> t) {
+   std::sort(t.begin(), t.end());
+   double median = t[t.size()/2];
+   std::vector<double> dev;
+   for (double v: t) {
+      dev.push_back(std::abs(v - median));
+   }
+   std::sort(dev.begin(), dev.end());
+   return measurement{phase, n, k, median, dev[dev.size()/2], nnz};
+}
+
+static std::vector<measurement> run_suite() {
+   std::vector<measurement> result;
+   for (const suite_entry &e: suite) {
+      std::vector<double> generate, assemble, analyse, reorder, solve;
+      long nnz = 0;
+      for (int r = 0; r < REGRESS_REPEATS; ++r) {
+         graph::seed(REGRESS_SEED);
+         auto start = bench_clock::now();
+         graph g = graph::random(e.n, e.k);
+         if (!g.is_connected())
+            g.make_connected();
+         generate.push_back(seconds_since(start));
+
+         start = bench_clock::now();
+         graph_stats::analyse(g);
+         analyse.push_back(seconds_since(start));
+
+         int *row_idx, *columns;
+         double *values;
+         start = bench_clock::now();
+         int n = assemble_upper_csr(g, &row_idx, &columns, &values);
+         assemble.push_back(seconds_since(start));
+         nnz = row_idx[n] - 1;
+
+#ifdef WITH_PARDISO
+         //solver takes over the arrays, the constructor checks the matrix
+         //and runs the reordering and symbolic factorization (phase 11)
+         start = bench_clock::now();
+         solver s(n, row_idx, columns, values);
+         reorder.push_back(seconds_since(start));
+         solve.push_back(s.solve());
+#else
+         delete[] row_idx;
+         delete[] columns;
+         delete[] values;
+#endif
+      }
+      result.push_back(summarise("generate", e.n, e.k, nnz, generate));
+      result.push_back(summarise("assemble", e.n, e.k, nnz, assemble));
+      result.push_back(summarise("analyse", e.n, e.k, nnz, analyse));
+      if (!solve.empty()) {
+         result.push_back(summarise("reorder", e.n, e.k, nnz, reorder));
+         result.push_back(summarise("solve", e.n, e.k, nnz, solve));
+      }
+      std::cout << "n=" << e.n << " k=" << e.k << " done" << std::endl;
+   }
+   return result;
+}
+
+static bool write_baseline(const char *file, const std::vector<measurement> &ms) {
+   FILE *out = fopen(file, "w");
+   if (!out)
+      return false;
+   fprintf(out, "phase,n,k,median,mad,nnz\n");
+   for (const measurement &m: ms) {
+      fprintf(out, "%s,%d,%d,%.9f,%.9f,%ld\n", m.phase.c_str(), m.n, m.k, m.median, m.mad, m.nnz);
+   }
+   return fclose(out) == 0;
+}
+
+static bool read_baseline(const char *file, std::vector<measurement> *ms) {
+   FILE *in = fopen(file, "r");
+   if (!in)
+      return false;
+   char line[256], phase[32];
+   if (!fgets(line, sizeof(line), in)) { //header
+      fclose(in);
+      return false;
+   }
+   measurement m;
+   while (fgets(line, sizeof(line), in)) {
+      if (sscanf(line, "%31[^,],%d,%d,%lf,%lf,%ld", phase, &m.n, &m.k, &m.median, &m.mad, &m.nnz) == 6) {
+         m.phase = phase;
+         ms->push_back(m);
+      }
+   }
+   fclose(in);
+   return true;
+}
+
+/**
+ * @return number of regressions and baseline phases missing from cur
+ */
+static int compare(const std::vector<measurement> &base, const std::vector<measurement> &cur,
+                   double tolerance) {
+   int regressions = 0;
+   printf("%-9s %6s %3s %11s %11s %8s %11s  %s\n",
+          "phase", "n", "k", "base[s]", "current[s]", "diff", "allowed[s]", "status");
+   for (const measurement &c: cur) {
+      auto b = std::find_if(base.begin(), base.end(), [&c](const measurement &m) {
+         return m.phase == c.phase && m.n == c.n && m.k == c.k;
+      });
+      if (b == base.end()) {
+         printf("%-9s %6d %3d %11s %11.6f %8s %11s  new\n", c.phase.c_str(), c.n, c.k, "-", c.median, "-", "-");
+         continue;
+      }
+
+      //1.4826*mad estimates the standard deviation
+      double noise = REGRESS_MAD_FACTOR * 1.4826 * std::max(b->mad, c.mad);
+      double allowed = std::max(std::max(tolerance * b->median, noise), REGRESS_MIN_DIFF);
+      double diff = c.median - b->median;
+      const char *status = "ok";
+      if (diff > allowed) {
+         status = "REGRESSION";
+         regressions++;
+      } else if (-diff > allowed) {
+         status = "faster";
+      }
+      printf("%-9s %6d %3d %11.6f %11.6f %+7.1f%% %11.6f  %s%s\n", c.phase.c_str(), c.n, c.k,
+             b->median, c.median, 100.0 * diff / b->median, allowed, status,
+             b->nnz != c.nnz ? " (graph changed)" : "");
+   }
+
+   //a phase of the baseline that did not run, e.g. solve without pardiso, fails too
+   for (const measurement &b: base) {
+      auto c = std::find_if(cur.begin(), cur.end(), [&b](const measurement &m) {
+         return m.phase == b.phase && m.n == b.n && m.k == b.k;
+      });
+      if (c == cur.end()) {
+         printf("%-9s %6d %3d %11.6f %11s %8s %11s  MISSING\n", b.phase.c_str(), b.n, b.k, b.median, "-", "-", "-");
+         regressions++;
+      }
+   }
+   return regressions;
+}
+
+int main(int argc, char **argv) {
+   if (argc < 3 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "check") != 0)) {
+      std::cout << "usage: " << argv[0] << " record|check baseline_file [tolerance]" << std::endl;
+      return 2;
+   }
+   const char *baseline_file = argv[2];
+   double tolerance = argc > 3 ? atof(argv[3]) : REGRESS_TOLERANCE;
+
+#ifdef WITH_PARDISO
+   if (!getenv("OMP_NUM_THREADS")) {
+      std::cout << "set OMP_NUM_THREADS" << std::endl;
+      return 2;
+   }
+#endif
+
+   std::vector<measurement> base;
+   if (strcmp(argv[1], "check") == 0 && !read_baseline(baseline_file, &base)) {
+      std::cerr << "could not read baseline " << baseline_file << std::endl;
+      return 2;
+   }
+
+   std::vector<measurement> cur = run_suite();
+
+   if (strcmp(argv[1], "record") == 0) {
+      if (!write_baseline(baseline_file, cur)) {
+         std::cerr << "could not write baseline " << baseline_file << std::endl;
+         return 2;
+      }
+      std::cout << "baseline written to " << baseline_file << std::endl;
+      return 0;
+   }
+
+   int regressions = compare(base, cur, tolerance);
+   if (regressions) {
+      std::cout << regressions << " regression(s) or missing phase(s)" << std::endl;
+      return 1;
+   }
+   std::cout << "no regressions" << std::endl;
+   return 0;
+}
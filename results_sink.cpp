@@ -0,0 +1,208 @@
+#include "results_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define RESULTS_BATCH 1024
+
+static int open_append(const char *file, const std::string &header) {
+    int out = open(file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (out < 0) {
+        perror(file);
+        return -1;
+    }
+    if (lseek(out, 0, SEEK_END) == 0) {
+        std::string line = header + "\n";
+        if (write(out, line.data(), line.size()) != ssize_t(line.size())) {
+            perror(file);
+        }
+    }
+    return out;
+}
+
+results_sink::results_sink(const char *file, const std::string &header,
+                           const std::string &text_column, const char *binary_file,
+                           std::chrono::milliseconds sync_interval)
+    : queue(RESULTS_QUEUE_SIZE), head(0), tail(0), pushed(0), synced(0), flush_requests(0),
+      stop(false), failed(false), binary_failed(false), binary_fd(-1), sync_interval(sync_interval) {
+    for (size_t i = 0; i < queue.size(); ++i) {
+        queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    columns = std::count(header.begin(), header.end(), ',') + 1;
+
+    fd = open_append(file, text_column.empty() ? header : header + "," + text_column);
+    if (binary_file) {
+        binary_fd = open(binary_file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (binary_fd < 0) {
+            perror(binary_file);
+            binary_failed = true;
+        }
+        std::string header_file = std::string(binary_file) + ".hdr";
+        int hdr = open(header_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        std::string line = header + "\n";
+        if (hdr < 0 || write(hdr, line.data(), line.size()) != ssize_t(line.size())) {
+            perror(header_file.c_str());
+        }
+        if (hdr >= 0)
+            close(hdr);
+    }
+    thread = std::thread(&results_sink::writer, this);
+}
+
+results_sink::~results_sink() {
+    stop.store(true, std::memory_order_release);
+    thread.join();
+    if (fd >= 0)
+        close(fd);
+    if (binary_fd >= 0)
+        close(binary_fd);
+}
+
+void results_sink::push(const record &r) {
+    const size_t mask = queue.size() - 1;
+    size_t pos = head.load(std::memory_order_relaxed);
+    cell *c;
+    for (;;) {
+        c = &queue[pos & mask];
+        size_t seq = c->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            //full, the writer is behind
+            std::this_thread::yield();
+            pos = head.load(std::memory_order_relaxed);
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+    c->r = r;
+    c->sequence.store(pos + 1, std::memory_order_release);
+    pushed.fetch_add(1, std::memory_order_release);
+}
+
+void results_sink::push(std::initializer_list<double> fields, const char *text) {
+    record r;
+    r.count = std::min<int>(fields.size(), RESULTS_MAX_FIELDS);
+    std::copy(fields.begin(), fields.begin() + r.count, r.fields);
+    r.text[0] = 0;
+    if (text) {
+        strncpy(r.text, text, RESULTS_MAX_TEXT - 1);
+        r.text[RESULTS_MAX_TEXT - 1] = 0;
+    }
+    push(r);
+}
+
+void results_sink::flush() {
+    size_t target = pushed.load(std::memory_order_acquire);
+    flush_requests.fetch_add(1);
+    while (synced.load(std::memory_order_acquire) < target && thread.joinable()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    flush_requests.fetch_sub(1);
+}
+
+size_t results_sink::drain(std::string *csv, std::string *bin) {
+    const size_t mask = queue.size() - 1;
+    char field[32];
+    size_t n = 0;
+    for (; n < RESULTS_BATCH; ++n) {
+        cell &c = queue[tail & mask];
+        if (c.sequence.load(std::memory_order_acquire) != tail + 1)
+            break;
+
+        const record &r = c.r;
+        for (int i = 0; i < r.count; ++i) {
+            snprintf(field, sizeof(field), i ? ",%.15g" : "%.15g", r.fields[i]);
+            csv->append(field);
+        }
+        if (r.text[0]) {
+            csv->append(",");
+            csv->append(r.text);
+        }
+        csv->append("\n");
+
+        if (binary_fd >= 0) {
+            for (int i = 0; i < columns; ++i) {
+                double v = i < r.count ? r.fields[i] : NAN;
+                bin->append(reinterpret_cast<const char *>(&v), sizeof(v));
+            }
+        }
+
+        c.sequence.store(tail + mask + 1, std::memory_order_release);
+        tail++;
+    }
+    return n;
+}
+
+void results_sink::write_out(int out, const std::string &data, std::atomic<bool> &out_failed) {
+    if (out_failed)
+        return;
+    //only the writer thread appends, so this is where the batch starts
+    off_t start = lseek(out, 0, SEEK_END);
+    const char *p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t w = write(out, p, left);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0) {
+            perror("results_sink");
+            //drop the partial batch so the file ends with a complete row
+            if (start >= 0 && ftruncate(out, start) != 0)
+                perror("results_sink truncate");
+            out_failed = true;
+            break;
+        }
+        p += w;
+        left -= w;
+    }
+}
+
+void results_sink::writer() {
+    typedef std::chrono::steady_clock clock;
+    auto last_sync = clock::now();
+    size_t count = 0;
+    bool dirty = false;
+    std::string csv, bin;
+
+    for (;;) {
+        bool stopping = stop.load(std::memory_order_acquire);
+        csv.clear();
+        bin.clear();
+        size_t n = drain(&csv, &bin);
+        if (n) {
+            if (fd >= 0)
+                write_out(fd, csv, failed);
+            if (binary_fd >= 0)
+                write_out(binary_fd, bin, binary_failed);
+            count += n;
+            dirty = true;
+        }
+
+        auto now = clock::now();
+        if (dirty && (stopping || flush_requests.load() > 0 || now - last_sync >= sync_interval)) {
+            if (fd >= 0)
+                fdatasync(fd);
+            if (binary_fd >= 0)
+                fdatasync(binary_fd);
+            last_sync = now;
+            dirty = false;
+            synced.store(count, std::memory_order_release);
+        }
+
+        if (n == 0) {
+            if (stopping)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
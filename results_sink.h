@@ -0,0 +1,104 @@
+#ifndef RESULTS_SINK_H
+#define RESULTS_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define RESULTS_MAX_FIELDS 32
+#define RESULTS_MAX_TEXT 1024
+#define RESULTS_QUEUE_SIZE 4096 //power of two
+
+/**
+ * @brief appends complete result records from any thread to a csv file
+ *
+ * Records are passed through a bounded lock free queue to a background
+ * thread which appends them in batches of complete rows, fsync is called at
+ * most every sync_interval. If a write fails the file is cut back to the end
+ * of the previous batch. The kernel may still split a batch into several
+ * writes, so a crash of the process in between can leave a partial last line,
+ * readers should drop a last line without newline. Records pushed before the
+ * sink is destroyed are written and synced by the destructor.
+ *
+ * Optionally the numeric fields are written to a binary file too, one row of
+ * doubles per record with as many doubles as the header has columns. The
+ * header line goes to binary_file.hdr so the rows start at offset 0. A failing
+ * binary file is given up on its own, the csv is still written.
+ */
+class results_sink {
+public:
+    struct record {
+        int count;                      //number of used fields
+        double fields[RESULTS_MAX_FIELDS];
+        char text[RESULTS_MAX_TEXT];    //optional last csv column, csv only
+    };
+
+    /**
+     * @param file csv file, appended to, the header is written if it is empty
+     * @param header comma separated names of the numeric columns
+     * @param text_column name of the text column or empty if there is none
+     * @param binary_file binary copy of the numeric fields or 0
+     * @param sync_interval maximum time records stay unsynced
+     */
+    results_sink(const char *file, const std::string &header, const std::string &text_column = "",
+                 const char *binary_file = 0,
+                 std::chrono::milliseconds sync_interval = std::chrono::milliseconds(500));
+
+    /**
+     * @brief writes all queued records and syncs
+     */
+    ~results_sink();
+
+    /**
+     * @brief queue a record, never waits for i/o, only spins if the queue is full
+     */
+    void push(const record &r);
+
+    /**
+     * @brief convenience for records without text
+     */
+    void push(std::initializer_list<double> fields, const char *text = 0);
+
+    /**
+     * @brief block until everything pushed so far is written and synced
+     */
+    void flush();
+
+    /**
+     * @brief false once the csv could not be opened or a write to it failed
+     */
+    bool ok() const { return fd >= 0 && !failed; }
+
+    /**
+     * @brief false once the binary file could not be opened or written
+     */
+    bool binary_ok() const { return !binary_failed; }
+
+private:
+    void writer();
+    size_t drain(std::string *csv, std::string *bin);
+    void write_out(int out, const std::string &data, std::atomic<bool> &out_failed);
+
+    struct cell {
+        std::atomic<size_t> sequence;
+        record r;
+    };
+
+    std::vector<cell> queue;
+    std::atomic<size_t> head; //next slot to push
+    size_t tail;              //next slot to pop, writer thread only
+
+    std::atomic<size_t> pushed, synced;
+    std::atomic<int> flush_requests;
+    std::atomic<bool> stop, failed, binary_failed;
+
+    int fd, binary_fd;
+    int columns;
+    std::chrono::milliseconds sync_interval;
+    std::thread thread;
+};
+
+#endif // RESULTS_SINK_H
@@ -0,0 +1,313 @@
+#include "schwarz.h"
+#include "graph.h"
+#include "solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+enum { CMD_QUIT = 0, CMD_SOLVE = 1 };
+
+/**
+ * @brief MSG_NOSIGNAL turns a dead peer into EPIPE instead of a SIGPIPE
+ * @return false if the peer is gone
+ */
+static bool send_all(int fd, const void *data, size_t size) {
+    const char *p = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t w = send(fd, p, size, MSG_NOSIGNAL);
+        if (w <= 0) {
+            return false;
+        }
+        p += w;
+        size -= w;
+    }
+    return true;
+}
+
+static void write_all(int fd, const void *data, size_t size) {
+    if (!send_all(fd, data, size)) {
+        perror("dd worker connection lost");
+        exit(-1);
+    }
+}
+
+static bool read_all(int fd, void *data, size_t size) {
+    char *p = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t r = read(fd, p, size);
+        if (r <= 0) {
+            return false;
+        }
+        p += r;
+        size -= r;
+    }
+    return true;
+}
+
+static void read_or_die(int fd, void *data, size_t size) {
+    if (!read_all(fd, data, size)) {
+        std::cerr << "dd worker connection lost" << std::endl;
+        exit(-1);
+    }
+}
+
+static double dot(const std::vector<double> &a, const std::vector<double> &b) {
+    double s = 0.0;
+#pragma omp parallel for reduction(+:s)
+    for (int i = 0; i < a.size(); ++i) {
+        s += a[i]*b[i];
+    }
+    return s;
+}
+
+schwarz::schwarz(const graph &g, const std::vector<int> &part, int overlap)
+    : n(g.nodes.size()), iters(0), res(0.0) {
+    std::vector<std::vector<int> > adj = g.symmetrised();
+
+    row_ptr.resize(n+1);
+    row_ptr[0] = 0;
+    for (int i = 0; i < n; ++i) {
+        row_ptr[i+1] = row_ptr[i] + adj[i].size() + 1;
+    }
+
+    cols.resize(row_ptr[n]);
+    vals.resize(row_ptr[n]);
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        int c = row_ptr[i];
+        bool diag = false;
+        for (int j: adj[i]) {
+            if (!diag && j > i) {
+                cols[c] = i; vals[c++] = adj[i].size() + 1.0;
+                diag = true;
+            }
+            cols[c] = j; vals[c++] = -1.0;
+        }
+        if (!diag) {
+            cols[c] = i; vals[c++] = adj[i].size() + 1.0;
+        }
+    }
+
+    int parts = *std::max_element(part.begin(), part.end()) + 1;
+    subs.resize(parts);
+    std::vector<int> mark(n);
+    for (int p = 0; p < parts; ++p) {
+        std::vector<int> &nodes = subs[p].nodes;
+        std::fill(mark.begin(), mark.end(), 0);
+        for (int i = 0; i < n; ++i) {
+            if (part[i] == p) {
+                nodes.push_back(i);
+                mark[i] = 1;
+            }
+        }
+        size_t layer_begin = 0;
+        for (int l = 0; l < overlap; ++l) {
+            size_t layer_end = nodes.size();
+            for (size_t v = layer_begin; v < layer_end; ++v) {
+                for (int j: adj[nodes[v]]) {
+                    if (!mark[j]) {
+                        mark[j] = 1;
+                        nodes.push_back(j);
+                    }
+                }
+            }
+            layer_begin = layer_end;
+        }
+        std::sort(nodes.begin(), nodes.end());
+        subs[p].buf.resize(nodes.size());
+        subs[p].fd = -1;
+        subs[p].pid = -1;
+    }
+}
+
+schwarz::~schwarz() {
+    int cmd = CMD_QUIT;
+    for (subdomain &s: subs) {
+        if (s.fd < 0)
+            continue;
+        send_all(s.fd, &cmd, sizeof(cmd)); //fails if the worker already exited
+        close(s.fd);
+        waitpid(s.pid, 0, 0);
+    }
+}
+
+double schwarz::setup(int threads) {
+    auto start = std::chrono::steady_clock::now();
+
+    //environment for the workers, prepared before fork
+    std::string omp = "OMP_NUM_THREADS=" + std::to_string(threads);
+    std::vector<char *> envp;
+    for (char **e = environ; *e; ++e) {
+        if (strncmp(*e, "OMP_NUM_THREADS=", 16) != 0)
+            envp.push_back(*e);
+    }
+    envp.push_back(&omp[0]);
+    envp.push_back(0);
+
+    std::vector<int> local(n, -1);
+    for (subdomain &s: subs) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+            perror("socketpair");
+            exit(-1);
+        }
+        fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+
+        char fd_arg[16];
+        snprintf(fd_arg, sizeof(fd_arg), "%d", sv[1]);
+        char arg0[] = "dd-worker", arg1[] = "--dd-worker";
+        char *argv[] = {arg0, arg1, fd_arg, 0};
+
+        s.pid = fork();
+        if (s.pid == 0) {
+            execve("/proc/self/exe", argv, envp.data());
+            _exit(127);
+        } else if (s.pid < 0) {
+            perror("fork");
+            exit(-1);
+        }
+        close(sv[1]);
+        s.fd = sv[0];
+
+        //local matrix, 1-based upper triangle as pardiso wants it
+        int m = s.nodes.size();
+        for (int l = 0; l < m; ++l) {
+            local[s.nodes[l]] = l;
+        }
+        std::vector<int> lrow(m+1), lcol;
+        std::vector<double> lval;
+        lrow[0] = 1;
+        for (int l = 0; l < m; ++l) {
+            int i = s.nodes[l];
+            for (int c = row_ptr[i]; c < row_ptr[i+1]; ++c) {
+                int lj = local[cols[c]];
+                if (lj < l) //outside the subdomain or lower triangle
+                    continue;
+                lcol.push_back(lj+1);
+                lval.push_back(vals[c]);
+            }
+            lrow[l+1] = lcol.size() + 1;
+        }
+        for (int l = 0; l < m; ++l) {
+            local[s.nodes[l]] = -1;
+        }
+
+        int nnz = lcol.size();
+        write_all(s.fd, &m, sizeof(m));
+        write_all(s.fd, &nnz, sizeof(nnz));
+        write_all(s.fd, lrow.data(), lrow.size()*sizeof(int));
+        write_all(s.fd, lcol.data(), lcol.size()*sizeof(int));
+        write_all(s.fd, lval.data(), lval.size()*sizeof(double));
+    }
+
+    for (subdomain &s: subs) {
+        double factor_time;
+        read_or_die(s.fd, &factor_time, sizeof(factor_time));
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void schwarz::precondition(const std::vector<double> &r, std::vector<double> &z) {
+    int cmd = CMD_SOLVE;
+    for (subdomain &s: subs) {
+        for (size_t l = 0; l < s.nodes.size(); ++l) {
+            s.buf[l] = r[s.nodes[l]];
+        }
+        write_all(s.fd, &cmd, sizeof(cmd));
+        write_all(s.fd, s.buf.data(), s.buf.size()*sizeof(double));
+    }
+
+    std::fill(z.begin(), z.end(), 0.0);
+    for (subdomain &s: subs) {
+        read_or_die(s.fd, s.buf.data(), s.buf.size()*sizeof(double));
+        for (size_t l = 0; l < s.nodes.size(); ++l) {
+            z[s.nodes[l]] += s.buf[l];
+        }
+    }
+}
+
+void schwarz::multiply(const std::vector<double> &v, std::vector<double> &out) const {
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        double s = 0.0;
+        for (int c = row_ptr[i]; c < row_ptr[i+1]; ++c) {
+            s += vals[c]*v[cols[c]];
+        }
+        out[i] = s;
+    }
+}
+
+double schwarz::solve(double tol, int max_iter) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<double> x(n, 0.0), r(n, 1.0), z(n), p(n), q(n);
+    double b_norm = std::sqrt(double(n));
+
+    precondition(r, z);
+    p = z;
+    double rz = dot(r, z);
+    res = 1.0;
+
+    for (iters = 0; iters < max_iter && res > tol; ) {
+        multiply(p, q);
+        double alpha = rz / dot(p, q);
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i) {
+            x[i] += alpha*p[i];
+            r[i] -= alpha*q[i];
+        }
+        iters++;
+        res = std::sqrt(dot(r, r)) / b_norm;
+        if (res <= tol)
+            break;
+
+        precondition(r, z);
+        double rz_new = dot(r, z);
+        double beta = rz_new / rz;
+        rz = rz_new;
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i) {
+            p[i] = z[i] + beta*p[i];
+        }
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int schwarz::worker(int fd) {
+    int m, nnz;
+    read_or_die(fd, &m, sizeof(m));
+    read_or_die(fd, &nnz, sizeof(nnz));
+    int *row_idx = new int[m+1];
+    int *columns = new int[nnz];
+    double *values = new double[nnz];
+    read_or_die(fd, row_idx, (m+1)*sizeof(int));
+    read_or_die(fd, columns, nnz*sizeof(int));
+    read_or_die(fd, values, nnz*sizeof(double));
+
+    solver s(m, row_idx, columns, values);
+    double factor_time = s.factorize();
+    write_all(fd, &factor_time, sizeof(factor_time));
+
+    std::vector<double> r(m), z(m);
+    int cmd;
+    while (read_all(fd, &cmd, sizeof(cmd)) && cmd == CMD_SOLVE) {
+        read_or_die(fd, r.data(), m*sizeof(double));
+        s.solve(r.data(), z.data());
+        write_all(fd, z.data(), m*sizeof(double));
+    }
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#ifndef SCHWARZ_H
+#define SCHWARZ_H
+
+#include <vector>
+#include <sys/types.h>
+
+class graph;
+
+/**
+ * @brief additive schwarz preconditioned cg on the shifted graph laplacian
+ *
+ * The matrix has degree+1 on the diagonal and -1 for every (symmetrised)
+ * edge. Every part, grown by overlap layers of neighbors, is factorised by
+ * pardiso in its own worker process. Workers are the running executable
+ * started again as "exe --dd-worker fd", its main has to hand over to
+ * schwarz::worker in that case. Vectors are exchanged over unix sockets.
+ */
+class schwarz {
+public:
+    /**
+     * @param g the graph
+     * @param part part of every node, see partition_rcb
+     * @param overlap number of neighbor layers added to every part
+     */
+    schwarz(const graph &g, const std::vector<int> &part, int overlap = 1);
+
+    /**
+     * @brief stops the workers
+     */
+    ~schwarz();
+
+    /**
+     * @brief start the workers and factorise all subdomains
+     * @param threads OMP_NUM_THREADS of every worker
+     * @return wall time until the slowest worker is done
+     */
+    double setup(int threads);
+
+    /**
+     * @brief solve the system for b = 1
+     * @param tol relative residual to reach
+     * @param max_iter maximum number of cg iterations
+     * @return wall time
+     */
+    double solve(double tol = 1e-8, int max_iter = 500);
+
+    int iterations() const { return iters; }
+    double residual() const { return res; }
+
+    /**
+     * @brief entry of a worker process
+     * @param fd socket connected to the master
+     * @return exit code
+     */
+    static int worker(int fd);
+
+private:
+    void precondition(const std::vector<double> &r, std::vector<double> &z);
+    void multiply(const std::vector<double> &v, std::vector<double> &out) const;
+
+    struct subdomain {
+        std::vector<int> nodes; //global ids, sorted
+        std::vector<double> buf;
+        int fd;
+        pid_t pid;
+    };
+
+    int n;
+    std::vector<int> row_ptr, cols; //full pattern including the diagonal, 0-based
+    std::vector<double> vals;
+    std::vector<subdomain> subs;
+    int iters;
+    double res;
+};
+
+#endif // SCHWARZ_H
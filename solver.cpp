@@ -1,47 +1,33 @@
 #include "solver.h"
 #include "graph.h"
+#include "csr.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 
-solver::solver(graph &g) : g(g), n(g.nodes.size()) {
-    row_idx = new int[n+1];
+static float seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+solver::solver(graph &g) {
+    n = assemble_upper_csr(g, &row_idx, &columns, &values);
+    nnz = row_idx[n] - 1;
     b = new double[n];
     x = new double[n];
     
     std::fill_n(b, n, 1.0);
-    row_idx[0] = 1;
-    
-    nnz = 0;
-    
-    for (int i = 0; i < g.connections.size(); ++i) {
-        int nz = 0;
-        for (int j = 0; j < g.connections[i].size(); ++j) {
-            if (g.connections[i][j] >= i) //only upper triangle part
-                nz++;
-        }
-        nnz += nz;
-        row_idx[i+1] = nnz + 1;
-    }
-    
-    
-    values = new double[nnz];
-    std::fill(values, values + nnz, 1.0);
-    columns = new int[nnz];
-            
-    int c = 0;
-    
-    for (int i = 0; i < g.connections.size(); ++i) {
-        std::sort(g.connections[i].begin(), g.connections[i].end());
-        for (int j = 0; j < g.connections[i].size(); ++j) {
-            if (g.connections[i][j] < i) //only upper triangle part
-                continue;
-            columns[c++] = g.connections[i][j]+1;
-        }
-    }
     
     init();
 }
 
+solver::solver(int n, int *row_idx, int *columns, double *values)
+    : n(n), nnz(row_idx[n] - 1), values(values), columns(columns), row_idx(row_idx) {
+    b = new double[n];
+    x = new double[n];
+    std::fill_n(b, n, 1.0);
+    init();
+}
+
 /* PARDISO prototype. */
 extern "C" {
 void pardisoinit (void   *, int    *,   int *, int *, double *, int *);
@@ -69,9 +55,12 @@ solver::~solver() {
     delete[] row_idx;
     delete[] values;
     delete[] columns;
+    delete[] b;
+    delete[] x;
 }
 
 float solver::solve() {
+    auto start = std::chrono::steady_clock::now();
     int error;
     int phase = 23;
     pardiso (handle, &maxfct, &mnum, &mtype, &phase,
@@ -82,6 +71,35 @@ float solver::solve() {
         printf("\nERROR during solution: %d", error);
         exit(3);
     }
+    return seconds_since(start);
+}
+
+float solver::factorize() {
+    auto start = std::chrono::steady_clock::now();
+    int error;
+    int phase = 22;
+    pardiso (handle, &maxfct, &mnum, &mtype, &phase,
+             &n, values, row_idx, columns, 0/*perm*/, &nrhs,
+             iparm, &msglvl, 0, 0, &error,  dparm);
+    
+    if (error != 0) {
+        printf("ERROR during numerical factorization: %d\n", error);
+        exit(2);
+    }
+    return seconds_since(start);
+}
+
+void solver::solve(double *rhs, double *sol) {
+    int error;
+    int phase = 33;
+    pardiso (handle, &maxfct, &mnum, &mtype, &phase,
+             &n, values, row_idx, columns, 0/*perm*/, &nrhs,
+             iparm, &msglvl, rhs, sol, &error,  dparm);
+    
+    if (error != 0) {
+        printf("\nERROR during solution: %d", error);
+        exit(3);
+    }
 }
 
 void solver::init() {
@@ -10,6 +10,15 @@ struct solver {
      */
     solver(graph &g);
     
+    /**
+     * @brief take over a 1-based upper triangular csr matrix allocated with new[]
+     * @param n number of rows
+     * @param row_idx n+1 row offsets
+     * @param columns column indices
+     * @param values matrix values
+     */
+    solver(int n, int *row_idx, int *columns, double *values);
+    
     virtual ~solver();
     
     /**
@@ -18,10 +27,22 @@ struct solver {
      */
     float solve();
     
+    /**
+     * @brief numerical factorization, needed once before solve(rhs, sol)
+     * @return time taken to factorize
+     */
+    float factorize();
+    
+    /**
+     * @brief solve for rhs using the factorization
+     * @param rhs right hand side of size n
+     * @param sol solution of size n
+     */
+    void solve(double *rhs, double *sol);
+    
 private:
     void init();
     
-    graph &g;
     int n, nnz;
     double *values, *b, *x;
     int *columns, *row_idx;
@@ -0,0 +1,186 @@
+#include "stats.h"
+#include "graph.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/minimum_degree_ordering.hpp>
+
+/**
+ * @brief minimum degree ordering, perm[new] = old
+ */
+static std::vector<int> min_degree_order(const std::vector<std::vector<int> > &adj) {
+    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS> bgraph;
+    int n = adj.size();
+    bgraph bg(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j: adj[i]) {
+            boost::add_edge(i, j, bg);
+        }
+    }
+
+    std::vector<int> inverse_perm(n, 0), perm(n, 0), degree(n, 0), supernode_sizes(n, 1);
+    boost::property_map<bgraph, boost::vertex_index_t>::type id = boost::get(boost::vertex_index, bg);
+    boost::minimum_degree_ordering(bg,
+            boost::make_iterator_property_map(&degree[0], id, degree[0]),
+            &inverse_perm[0], &perm[0],
+            boost::make_iterator_property_map(&supernode_sizes[0], id, supernode_sizes[0]),
+            0, id);
+    return perm;
+}
+
+graph_stats graph_stats::analyse(const graph &g) {
+    graph_stats s;
+    s.n = g.nodes.size();
+    s.bridges = 0;
+    const int n = s.n;
+
+    std::vector<std::vector<int> > adj = g.symmetrised();
+
+    long directed = 0, mutual = 0;
+#pragma omp parallel for reduction(+:directed, mutual)
+    for (int i = 0; i < n; ++i) {
+        for (int j: g.connections[i]) {
+            if (j == i)
+                continue;
+            directed++;
+            const std::vector<int> &back = g.connections[j];
+            if (std::find(back.begin(), back.end(), i) != back.end())
+                mutual++;
+        }
+    }
+    s.symmetry = directed ? double(mutual) / directed : 1.0;
+
+    long nnz = 0, profile = 0;
+    int min_degree = n, max_degree = 0, bandwidth = 0;
+#pragma omp parallel for reduction(+:nnz, profile) reduction(min:min_degree) reduction(max:max_degree, bandwidth)
+    for (int i = 0; i < n; ++i) {
+        int d = adj[i].size();
+        nnz += d;
+        min_degree = std::min(min_degree, d);
+        max_degree = std::max(max_degree, d);
+        if (d > 0) {
+            //sorted, so the first entry is the leftmost of row i
+            bandwidth = std::max(bandwidth, std::max(i - adj[i].front(), adj[i].back() - i));
+            profile += std::max(0, i - adj[i].front());
+        }
+    }
+    s.nnz = nnz;
+    s.profile = profile;
+    s.bandwidth = bandwidth;
+    s.min_degree = n ? min_degree : 0;
+    s.max_degree = max_degree;
+    s.avg_degree = n ? double(nnz) / n : 0.0;
+
+    s.degree_histogram.assign(max_degree+1, 0);
+    for (int i = 0; i < n; ++i) {
+        s.degree_histogram[adj[i].size()]++;
+    }
+
+    //symbolic factorization of the reordered pattern
+    std::vector<int> perm = min_degree_order(adj);
+    std::vector<int> inv(n);
+    for (int i = 0; i < n; ++i) {
+        inv[perm[i]] = i;
+    }
+    std::vector<std::vector<int> > lower(n);
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        for (int j: adj[perm[i]]) {
+            if (inv[j] < i)
+                lower[i].push_back(inv[j]);
+        }
+    }
+
+    //elimination tree, liu's algorithm with path compression
+    std::vector<int> parent(n, -1), ancestor(n, -1);
+    for (int i = 0; i < n; ++i) {
+        for (int j: lower[i]) {
+            while (j != -1 && j < i) {
+                int next = ancestor[j];
+                ancestor[j] = i;
+                if (next == -1)
+                    parent[j] = i;
+                j = next;
+            }
+        }
+    }
+
+    std::vector<int> depth(n, 0);
+    int height = 0;
+    for (int i = n-1; i >= 0; --i) {
+        depth[i] = parent[i] == -1 ? 1 : depth[parent[i]] + 1;
+        height = std::max(height, depth[i]);
+    }
+    s.etree_height = height;
+
+    //column counts by traversing the row subtrees
+    std::vector<int> col_count(n, 1);
+#pragma omp parallel
+    {
+        std::vector<int> mark(n, -1);
+#pragma omp for schedule(dynamic, 256)
+        for (int i = 0; i < n; ++i) {
+            mark[i] = i;
+            for (int j: lower[i]) {
+                for (int c = j; mark[c] != i; c = parent[c]) {
+                    mark[c] = i;
+#pragma omp atomic
+                    col_count[c]++;
+                }
+            }
+        }
+    }
+
+    long factor_nnz = 0;
+    double flops = 0.0;
+    for (int c: col_count) {
+        factor_nnz += c;
+        flops += double(c) * c;
+    }
+    s.factor_nnz = factor_nnz;
+    s.factor_mflops = flops * 1e-6;
+
+    return s;
+}
+
+const char *graph_stats::csv_header() {
+    return "nnz,symmetry,min_degree,max_degree,avg_degree,bandwidth,profile,"
+           "etree_height,factor_nnz,factor_mflops,bridges";
+}
+
+int graph_stats::fields(double *out) const {
+    double values[STATS_FIELDS] = {
+        double(nnz), symmetry, double(min_degree), double(max_degree), avg_degree,
+        double(bandwidth), double(profile), double(etree_height), double(factor_nnz),
+        factor_mflops, double(bridges)
+    };
+    std::copy(values, values + STATS_FIELDS, out);
+    return STATS_FIELDS;
+}
+
+std::string graph_stats::histogram() const {
+    std::string h;
+    for (size_t d = 0; d < degree_histogram.size(); ++d) {
+        if (d)
+            h += " ";
+        h += std::to_string(degree_histogram[d]);
+    }
+    return h;
+}
+
+void graph_stats::print(std::ostream &out) const {
+    out << "n " << n << " nnz " << nnz << " symmetry " << symmetry << std::endl
+        << "degree min " << min_degree << " avg " << avg_degree << " max " << max_degree << std::endl
+        << "bandwidth " << bandwidth << " profile " << profile << std::endl
+        << "etree height " << etree_height << " factor nnz " << factor_nnz
+        << " factor mflops " << factor_mflops << std::endl
+        << "bridges " << bridges << std::endl;
+    out << "degree histogram";
+    for (size_t d = 0; d < degree_histogram.size(); ++d) {
+        if (degree_histogram[d])
+            out << " " << d << ":" << degree_histogram[d];
+    }
+    out << std::endl;
+}
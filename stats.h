@@ -0,0 +1,64 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+#define STATS_FIELDS 11
+
+class graph;
+
+/**
+ * @brief structural properties of the matrix generated from a graph
+ *
+ * Everything is computed on the symmetrised pattern (i-j present if either
+ * node lists the other). Bandwidth and profile are for the natural node
+ * order, the symbolic factorization uses a minimum degree ordering which is
+ * closer to what the solvers actually do.
+ */
+struct graph_stats {
+    int n;
+    long nnz;                           //off diagonal entries, both triangles
+    double symmetry;                    //fraction of edges whose reverse is listed too
+    int min_degree, max_degree;
+    double avg_degree;
+    std::vector<int> degree_histogram;  //number of nodes per degree
+    int bandwidth;
+    long profile;
+    int etree_height;
+    long factor_nnz;                    //nnz of the cholesky factor incl. diagonal
+    double factor_mflops;
+    int bridges;                        //edges added by make_connected, set by the caller
+
+    /**
+     * @brief analyse graph g, runs in parallel
+     * @param g the graph
+     * @return the statistics, bridges is 0
+     */
+    static graph_stats analyse(const graph &g);
+
+    /**
+     * @brief comma separated names of the values written by fields
+     */
+    static const char *csv_header();
+
+    /**
+     * @brief scalar values in csv_header order
+     * @param out room for STATS_FIELDS values
+     * @return number of values written
+     */
+    int fields(double *out) const;
+
+    /**
+     * @brief degree histogram as space separated counts starting at degree 0
+     */
+    std::string histogram() const;
+
+    /**
+     * @brief human readable summary
+     */
+    void print(std::ostream &out) const;
+};
+
+#endif // STATS_H
@@ -0,0 +1,227 @@
+#include "tiled_graph.h"
+#include "vp-tree.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <sys/types.h>
+
+#include <boost/random.hpp>
+
+struct tiled_header {
+    char magic[8];
+    int64_t n;
+    int32_t k;
+    int32_t tiles;
+};
+
+static const char TILED_MAGIC[8] = "PWDCSR1";
+
+/**
+ * @brief splitmix64 finalizer, decorrelates seeds of neighboring tiles
+ */
+static uint64_t mix_seed(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+tiled_graph::tiled_graph(int64_t n, int k, uint64_t seed, int points_per_tile)
+    : n(n), k(k), seed(seed) {
+    assert(n > k && k > 0);
+    //node ids are stored as int32
+    assert(n <= INT32_MAX);
+    //a corner node only sees 4 tiles, they must hold at least k other nodes
+    points_per_tile = std::max(points_per_tile, k+1);
+    tiles = std::max<int64_t>(1, int64_t(std::sqrt(double(n) / points_per_tile)));
+}
+
+int64_t tiled_graph::tile_size(int64_t t) const {
+    int64_t nt = int64_t(tiles)*tiles;
+    return n / nt + (t < n % nt ? 1 : 0);
+}
+
+int64_t tiled_graph::tile_first(int64_t t) const {
+    int64_t nt = int64_t(tiles)*tiles;
+    return t * (n / nt) + std::min(t, n % nt);
+}
+
+void tiled_graph::make_tile(int tx, int ty, tile *out) const {
+    int64_t t = int64_t(ty)*tiles + tx;
+    boost::random::mt19937 rng(uint32_t(mix_seed(seed ^ mix_seed(t))));
+    boost::random::uniform_01<> gen;
+
+    double w = 1.0 / tiles;
+    out->first = tile_first(t);
+    out->nodes.resize(tile_size(t));
+    for (graph::coord &c: out->nodes) {
+        c.x = (tx + gen(rng)) * w;
+        c.y = (ty + gen(rng)) * w;
+    }
+}
+
+bool tiled_graph::generate(const char *file) const {
+    FILE *out = fopen(file, "wb");
+    if (!out) {
+        return false;
+    }
+
+    tiled_header header;
+    memcpy(header.magic, TILED_MAGIC, sizeof(header.magic));
+    header.n = n;
+    header.k = k;
+    header.tiles = tiles;
+    fwrite(&header, sizeof(header), 1, out);
+
+    const off_t node_base = sizeof(header);
+    const off_t column_base = node_base + off_t(n)*sizeof(graph::coord);
+
+    //rows[0] = ty-1, rows[1] = ty, rows[2] = ty+1
+    std::vector<tile> rows[3];
+    for (int r = 0; r < 3; ++r) {
+        rows[r].resize(tiles);
+    }
+
+#pragma omp parallel for
+    for (int tx = 0; tx < tiles; ++tx) {
+        make_tile(tx, 0, &rows[1][tx]);
+    }
+
+    std::vector<int32_t> columns;
+    std::vector<graph::coord> coords;
+    bool ok = true;
+
+    for (int ty = 0; ty < tiles && ok; ++ty) {
+        if (ty+1 < tiles) {
+#pragma omp parallel for
+            for (int tx = 0; tx < tiles; ++tx) {
+                make_tile(tx, ty+1, &rows[2][tx]);
+            }
+        }
+
+        int64_t row_first = rows[1][0].first;
+        int64_t row_size = 0;
+        for (const tile &t: rows[1]) {
+            row_size += t.nodes.size();
+        }
+        columns.resize(row_size*k);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int tx = 0; tx < tiles; ++tx) {
+            //own nodes first so local index i is node i of this tile
+            std::vector<graph::coord> cand(rows[1][tx].nodes);
+            std::vector<int64_t> ids;
+            for (size_t i = 0; i < cand.size(); ++i) {
+                ids.push_back(rows[1][tx].first + i);
+            }
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = tx + dx, ny = ty + dy;
+                    if ((dx == 0 && dy == 0) || nx < 0 || nx >= tiles || ny < 0 || ny >= tiles)
+                        continue;
+                    const tile &nb = rows[1+dy][nx];
+                    cand.insert(cand.end(), nb.nodes.begin(), nb.nodes.end());
+                    for (size_t i = 0; i < nb.nodes.size(); ++i) {
+                        ids.push_back(nb.first + i);
+                    }
+                }
+            }
+            assert(cand.size() > size_t(k));
+
+            auto dist_fun = [&cand](const int &i, const int &j){
+                return cand[i].dist(cand[j]);
+            };
+
+            VpTree<int, decltype(dist_fun)> tree(dist_fun);
+            std::vector<int> items(cand.size());
+            int first = 0;
+            std::generate(items.begin(), items.end(), [&first]{ return first++; });
+            tree.create(items);
+
+            const tile &own = rows[1][tx];
+            int32_t *col = &columns[(own.first - row_first)*k];
+            std::vector<int> nb;
+            std::vector<double> dists;
+            for (int i = 0; i < int(own.nodes.size()); ++i) {
+                tree.search(i, k+1, &nb, &dists);
+                //self always included, unless k+1 nodes share the position
+                auto self = std::find(nb.begin(), nb.end(), i);
+                if (self != nb.end()) {
+                    nb.erase(self);
+                } else {
+                    nb.pop_back();
+                }
+                for (int j = 0; j < k; ++j) {
+                    *col++ = int32_t(ids[nb[j]]);
+                }
+            }
+        }
+
+        coords.clear();
+        for (const tile &t: rows[1]) {
+            coords.insert(coords.end(), t.nodes.begin(), t.nodes.end());
+        }
+
+        ok = fseeko(out, node_base + off_t(row_first)*sizeof(graph::coord), SEEK_SET) == 0
+                && fwrite(coords.data(), sizeof(graph::coord), coords.size(), out) == coords.size()
+                && fseeko(out, column_base + off_t(row_first)*k*sizeof(int32_t), SEEK_SET) == 0
+                && fwrite(columns.data(), sizeof(int32_t), columns.size(), out) == columns.size();
+
+        std::swap(rows[0], rows[1]);
+        std::swap(rows[1], rows[2]);
+    }
+
+    return fclose(out) == 0 && ok;
+}
+
+graph tiled_graph::load(const char *file) {
+    graph g;
+    FILE *in = fopen(file, "rb");
+    if (!in) {
+        std::cerr << "could not open " << file << std::endl;
+        return g;
+    }
+
+    tiled_header header;
+    if (fread(&header, sizeof(header), 1, in) != 1
+            || memcmp(header.magic, TILED_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << file << " is not a tiled graph file" << std::endl;
+        fclose(in);
+        return g;
+    }
+
+    fseeko(in, 0, SEEK_END);
+    off_t size = ftello(in);
+    bool valid = header.k > 0 && header.n > header.k && header.n <= INT32_MAX
+            && size == off_t(sizeof(header)) + off_t(header.n)*sizeof(graph::coord)
+                       + off_t(header.n)*header.k*sizeof(int32_t);
+    if (!valid) {
+        std::cerr << file << " has an invalid header or size" << std::endl;
+        fclose(in);
+        return g;
+    }
+    fseeko(in, sizeof(header), SEEK_SET);
+
+    g.nodes.resize(header.n);
+    g.connections.resize(header.n);
+    size_t read = fread(g.nodes.data(), sizeof(graph::coord), header.n, in);
+
+    std::vector<int32_t> row(header.k);
+    for (int64_t i = 0; i < header.n && valid; ++i) {
+        read += fread(row.data(), sizeof(int32_t), header.k, in);
+        for (int32_t j: row) {
+            valid = valid && j >= 0 && j < header.n;
+        }
+        g.connections[i].assign(row.begin(), row.end());
+    }
+
+    fclose(in);
+    if (!valid || read != size_t(header.n)*(header.k+1)) {
+        std::cerr << file << " is corrupt" << std::endl;
+        return graph();
+    }
+    return g;
+}
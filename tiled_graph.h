@@ -0,0 +1,61 @@
+#ifndef TILED_GRAPH_H
+#define TILED_GRAPH_H
+
+#include <vector>
+#include <cstdint>
+#include "graph.h"
+
+/**
+ * @brief out of core generator for k nearest neighbor graphs
+ *
+ * The unit square is split into tiles*tiles spatial blocks. The points of a
+ * block are drawn from a generator seeded with (seed, block) so every block
+ * can be regenerated on its own. Neighbors are searched only in the 3x3
+ * blocks around a node and just three rows of blocks are held in memory.
+ *
+ * File layout (native endian):
+ *   header   "PWDCSR1\0", int64 n, int32 k, int32 tiles
+ *   nodes    n times double x, double y
+ *   columns  n*k int32 node ids, row i is [i*k, (i+1)*k)
+ */
+class tiled_graph {
+public:
+    /**
+     * @param n number of nodes, at most INT32_MAX
+     * @param k number of connections per node
+     * @param seed seed for the block generators
+     * @param points_per_tile average number of nodes per block
+     */
+    tiled_graph(int64_t n, int k, uint64_t seed, int points_per_tile = 64);
+
+    /**
+     * @brief generate the graph and stream it to file
+     * @param file where to
+     * @return false if the file could not be written
+     */
+    bool generate(const char *file) const;
+
+    /**
+     * @brief load a generated file into memory, only sensible for small n
+     * @param file
+     * @return the graph, empty if the file is invalid
+     */
+    static graph load(const char *file);
+
+private:
+    struct tile {
+        int64_t first;
+        std::vector<graph::coord> nodes;
+    };
+
+    int64_t tile_size(int64_t t) const;
+    int64_t tile_first(int64_t t) const;
+    void make_tile(int tx, int ty, tile *out) const;
+
+    int64_t n;
+    int k;
+    uint64_t seed;
+    int tiles;
+};
+
+#endif // TILED_GRAPH_H